@@ -0,0 +1,241 @@
+#include "csv_writer.h"
+#include <QtAlgorithms>
+#include <charconv>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSV_WRITER_SSE2
+#endif
+
+namespace {
+constexpr qsizetype kMaxIntChars = 20;    // "-9223372036854775808"
+constexpr qsizetype kMaxDoubleChars = 32; // кратчайшая запись double не длиннее 24 символов
+constexpr qsizetype kBlockBytes = 64 * 1024;
+
+constexpr char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+constexpr quint64 kPowersOf10[] = {
+    0, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull,
+};
+
+// Число десятичных цифр без цикла: log10 оценивается через номер старшего бита
+inline int decimalDigits(quint64 value) {
+    int bits = 64 - int(qCountLeadingZeroBits(value | 1));
+    int t = (bits * 1233) >> 12;
+    return t + 1 - int(value < kPowersOf10[t]);
+}
+
+inline char *writeUnsigned(char *out, quint64 value) {
+    char *end = out + decimalDigits(value);
+    char *p = end;
+    while (value >= 100) {
+        const char *pair = kDigitPairs + (value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        std::memcpy(p, pair, 2);
+    }
+    if (value >= 10) {
+        std::memcpy(p - 2, kDigitPairs + value * 2, 2);
+    } else {
+        p[-1] = char('0' + value);
+    }
+    return end;
+}
+
+inline char *writeInt(char *out, qint64 value) {
+    quint64 magnitude = quint64(value);
+    if (value < 0) {
+        *out++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    return writeUnsigned(out, magnitude);
+}
+
+inline char *writeDouble(char *out, double value) {
+    return std::to_chars(out, out + kMaxDoubleChars, value).ptr;
+}
+
+inline bool isSpecial(char c, char delimiter) {
+    return (c == delimiter) | (c == '"') | (c == '\n') | (c == '\r');
+}
+
+inline bool needsQuoting(const char *data, qsizetype size, char delimiter) {
+    qsizetype i = 0;
+#ifdef CSV_WRITER_SSE2
+    const __m128i delimiters = _mm_set1_epi8(delimiter);
+    const __m128i quotes = _mm_set1_epi8('"');
+    const __m128i lineFeeds = _mm_set1_epi8('\n');
+    const __m128i carriageReturns = _mm_set1_epi8('\r');
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiters), _mm_cmpeq_epi8(chunk, quotes)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeeds), _mm_cmpeq_epi8(chunk, carriageReturns)));
+        if (_mm_movemask_epi8(hits)) {
+            return true;
+        }
+    }
+#endif
+    bool found = false;
+    for (; i < size; ++i) {
+        found |= isSpecial(data[i], delimiter);
+    }
+    return found;
+}
+
+inline char *writeString(char *out, const char *data, qsizetype size, char delimiter) {
+    if (!needsQuoting(data, size, delimiter)) {
+        std::memcpy(out, data, size_t(size));
+        return out + size;
+    }
+    *out++ = '"';
+    for (qsizetype i = 0; i < size; ++i) {
+        if (data[i] == '"') {
+            *out++ = '"';
+        }
+        *out++ = data[i];
+    }
+    *out++ = '"';
+    return out;
+}
+
+inline qsizetype fixedLength(const char *slot, int width) {
+    const void *nul = std::memchr(slot, '\0', size_t(width));
+    return nul ? static_cast<const char *>(nul) - slot : width;
+}
+
+// Верхняя граница длины значения, включая разделитель после него
+inline qsizetype maxCellBytes(const CsvColumn &column) {
+    switch (column.type) {
+    case CsvColumn::Type::Int:
+        return kMaxIntChars + 1;
+    case CsvColumn::Type::Double:
+        return kMaxDoubleChars + 1;
+    case CsvColumn::Type::FixedString:
+        return qsizetype(column.width) * 2 + 3;
+    }
+    return 0;
+}
+}
+
+CsvColumn CsvColumn::fromInts(const qint64 *values) {
+    CsvColumn column;
+    column.type = Type::Int;
+    column.ints = values;
+    return column;
+}
+
+CsvColumn CsvColumn::fromDoubles(const double *values) {
+    CsvColumn column;
+    column.type = Type::Double;
+    column.doubles = values;
+    return column;
+}
+
+CsvColumn CsvColumn::fromFixedStrings(const char *values, int width) {
+    Q_ASSERT(width >= 0);
+    CsvColumn column;
+    column.type = Type::FixedString;
+    column.strings = values;
+    column.width = width;
+    return column;
+}
+
+CsvWriter::CsvWriter(QIODevice *device, qsizetype flushThreshold, char delimiter)
+    : m_device(device), m_flushThreshold(flushThreshold), m_delimiter(delimiter), m_size(0) {}
+
+void CsvWriter::writeHeader(const QList<QByteArray> &names) {
+    qsizetype bound = 1;
+    for (const QByteArray &name : names) {
+        bound += name.size() * 2 + 3;
+    }
+
+    char *begin = reserve(bound);
+    char *out = begin;
+    for (qsizetype i = 0; i < names.size(); ++i) {
+        if (i > 0) {
+            *out++ = m_delimiter;
+        }
+        out = writeString(out, names.at(i).constData(), names.at(i).size(), m_delimiter);
+    }
+    *out++ = '\n';
+    m_size += out - begin;
+}
+
+bool CsvWriter::writeBatch(const QVector<CsvColumn> &columns, qsizetype rows) {
+    if (columns.isEmpty() || rows <= 0) {
+        return true;
+    }
+
+    qsizetype rowBytes = 0;
+    for (const CsvColumn &column : columns) {
+        // Размер блока считается по width, поэтому некорректная колонка переполнила бы буфер
+        if (column.type == CsvColumn::Type::FixedString && (column.width < 0 || !column.strings)) {
+            return false;
+        }
+        if ((column.type == CsvColumn::Type::Int && !column.ints)
+            || (column.type == CsvColumn::Type::Double && !column.doubles)) {
+            return false;
+        }
+        rowBytes += maxCellBytes(column);
+    }
+    // Место резервируется сразу на блок строк, внутри блока проверок границ нет
+    qsizetype blockRows = qMax<qsizetype>(1, kBlockBytes / rowBytes);
+
+    for (qsizetype first = 0; first < rows; first += blockRows) {
+        qsizetype last = qMin(rows, first + blockRows);
+        char *begin = reserve((last - first) * rowBytes);
+        char *out = begin;
+
+        for (qsizetype row = first; row < last; ++row) {
+            for (const CsvColumn &column : columns) {
+                switch (column.type) {
+                case CsvColumn::Type::Int:
+                    out = writeInt(out, column.ints[row]);
+                    break;
+                case CsvColumn::Type::Double:
+                    out = writeDouble(out, column.doubles[row]);
+                    break;
+                case CsvColumn::Type::FixedString: {
+                    const char *slot = column.strings + row * column.width;
+                    out = writeString(out, slot, fixedLength(slot, column.width), m_delimiter);
+                    break;
+                }
+                }
+                *out++ = m_delimiter;
+            }
+            out[-1] = '\n';
+        }
+
+        m_size += out - begin;
+        if (m_device && m_size >= m_flushThreshold && !flush()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CsvWriter::flush() {
+    if (!m_device || m_size == 0) {
+        return true;
+    }
+    if (m_device->write(m_arena.constData(), m_size) != m_size) {
+        return false;
+    }
+    m_size = 0;
+    return true;
+}
+
+char *CsvWriter::reserve(qsizetype bytes) {
+    if (m_size + bytes > m_arena.size()) {
+        m_arena.resize(qMax(m_size + bytes, m_arena.size() * 2));
+    }
+    return m_arena.data() + m_size;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QIODevice>
+#include <QList>
+#include <QVector>
+
+// Колонка пакета значений. Данные не копируются: writer читает их по указателю.
+struct CsvColumn {
+    enum class Type { Int, Double, FixedString };
+
+    Type type = Type::Int;
+    const qint64 *ints = nullptr;
+    const double *doubles = nullptr;
+    const char *strings = nullptr;
+    int width = 0; // FixedString: размер слота; значение заканчивается на первом '\0' или на границе слота
+
+    static CsvColumn fromInts(const qint64 *values);
+    static CsvColumn fromDoubles(const double *values);
+    static CsvColumn fromFixedStrings(const char *values, int width);
+};
+
+// Пишет CSV по пакетам колонок в переиспользуемый буфер без аллокаций на значение.
+// Если задан device, буфер сбрасывается в него по достижении flushThreshold байт.
+class CsvWriter {
+public:
+    explicit CsvWriter(QIODevice *device = nullptr, qsizetype flushThreshold = 1 << 20, char delimiter = ',');
+
+    void writeHeader(const QList<QByteArray> &names);
+    bool writeBatch(const QVector<CsvColumn> &columns, qsizetype rows);
+    bool flush();
+    void clear() { m_size = 0; }
+
+    QByteArrayView buffer() const { return QByteArrayView(m_arena.constData(), m_size); }
+
+private:
+    char *reserve(qsizetype bytes);
+
+    QIODevice *m_device;
+    qsizetype m_flushThreshold;
+    char m_delimiter;
+    QByteArray m_arena;
+    qsizetype m_size;
+};
@@ -1,9 +1,13 @@
 #include "main_window.h"
+#include "startup_profiler.h"
 #include <QApplication>
 
 int main(int argc, char *argv[]) {
+    StartupProfiler::start();
     QApplication app(argc, argv);
+    StartupProfiler::mark("application created");
     MainWindow window;
+    StartupProfiler::mark("main window constructed");
     window.show();
     return QApplication::exec();
 }
\ No newline at end of file
@@ -8,29 +8,123 @@
 #include <QComboBox>
 #include <QSpinBox>
 #include <QLineEdit>
+#include <QFileInfo>
+#include <QTimer>
+#include <QCloseEvent>
+#include "startup_profiler.h"
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), networkThread(new QThread(this)), worker(new NetworkWorker()), requestSuccessful(false) {
+    : QMainWindow(parent), networkThread(nullptr), worker(nullptr), requestSuccessful(false),
+      firstFramePainted(false), networkReady(false), schemaRestored(false) {
+    setupUi();
+    connect(addFieldButton, &QPushButton::clicked, this, &MainWindow::addField);
+    connect(removeFieldButton, &QPushButton::clicked, this, &MainWindow::removeSelectedField);
+    connect(sendButton, &QPushButton::clicked, this, &MainWindow::sendRequest);
+    connect(cancelButton, &QPushButton::clicked, this, &MainWindow::cancelRequest);
+    connect(addToBatchButton, &QPushButton::clicked, this, &MainWindow::addTableToBatch);
+    connect(clearBatchButton, &QPushButton::clicked, this, &MainWindow::clearBatch);
+    connect(sendBatchButton, &QPushButton::clicked, this, &MainWindow::sendBatchRequest);
+}
+
+MainWindow::~MainWindow() {
+    if (networkThread) {
+        networkThread->quit();
+        networkThread->wait();
+    }
+}
+
+void MainWindow::paintEvent(QPaintEvent *event) {
+    QMainWindow::paintEvent(event);
+    if (!firstFramePainted) {
+        firstFramePainted = true;
+        // Сеть и кэш схемы поднимаем только после того, как окно уже нарисовано
+        QTimer::singleShot(0, this, &MainWindow::onFirstFrame);
+    }
+}
+
+void MainWindow::closeEvent(QCloseEvent *event) {
+    saveSchema();
+    QMainWindow::closeEvent(event);
+}
+
+void MainWindow::onFirstFrame() {
+    StartupProfiler::mark("first frame");
+    startNetwork();
+    restoreSchema();
+}
+
+void MainWindow::startNetwork() {
+    if (networkThread) return;
+
+    networkThread = new QThread(this);
+    worker = createNetworkWorker();
     worker->moveToThread(networkThread);
+    connect(networkThread, &QThread::started, worker, &NetworkWorker::initialize);
     connect(networkThread, &QThread::finished, worker, &QObject::deleteLater);
     connect(this, &MainWindow::destroyed, networkThread, &QThread::quit);
     connect(this, &MainWindow::sendNetworkRequest, worker, &NetworkWorker::processRequest);
     connect(this, &MainWindow::cancelNetworkRequest, worker, &NetworkWorker::cancelRequest);
+    connect(this, &MainWindow::sendNetworkBatchRequest, worker, &NetworkWorker::processBatchRequest);
+    connect(worker, &NetworkWorker::ready, this, &MainWindow::onNetworkReady);
     connect(worker, &NetworkWorker::dataReceived, this, &MainWindow::onDataReceived);
+    connect(worker, &NetworkWorker::batchFinished, this, &MainWindow::onBatchFinished);
     connect(worker, &NetworkWorker::finished, this, &MainWindow::onRequestFinished);
     connect(worker, &NetworkWorker::errorOccurred, this, &MainWindow::onErrorOccurred);
     networkThread->start();
+}
 
-    setupUi();
-    connect(addFieldButton, &QPushButton::clicked, this, &MainWindow::addField);
-    connect(removeFieldButton, &QPushButton::clicked, this, &MainWindow::removeSelectedField);
-    connect(sendButton, &QPushButton::clicked, this, &MainWindow::sendRequest);
-    connect(cancelButton, &QPushButton::clicked, this, &MainWindow::cancelRequest);
+void MainWindow::onNetworkReady() {
+    networkReady = true;
+    StartupProfiler::mark("network ready");
+    markReadyIfDone();
 }
 
-MainWindow::~MainWindow() {
-    networkThread->quit();
-    networkThread->wait();
+void MainWindow::restoreSchema() {
+    TableSchema schema;
+    if (!SchemaCache::load(&schema)) {
+        schemaRestored = true;
+        markReadyIfDone();
+        return;
+    }
+
+    tableNameEdit->setText(schema.tableName);
+    rowsSpinBox->setValue(schema.rows);
+    outputFileEdit->setText(schema.outputFile);
+    pendingFields = schema.fields;
+    // Пока строки восстанавливаются, добавление и удаление полей сдвигало бы их индексы
+    addFieldButton->setEnabled(false);
+    removeFieldButton->setEnabled(false);
+    restoreNextFields();
+}
+
+void MainWindow::restoreNextFields() {
+    // Строки добавляются порциями, чтобы окно оставалось отзывчивым на больших схемах
+    constexpr int kChunkSize = 64;
+    int count = qMin<int>(kChunkSize, pendingFields.size());
+
+    fieldsTable->setUpdatesEnabled(false);
+    for (int i = 0; i < count; ++i) {
+        addFieldRow(pendingFields.at(i));
+    }
+    fieldsTable->setUpdatesEnabled(true);
+    pendingFields.remove(0, count);
+
+    if (!pendingFields.isEmpty()) {
+        QTimer::singleShot(0, this, &MainWindow::restoreNextFields);
+        return;
+    }
+    pendingFields.squeeze();
+    addFieldButton->setEnabled(true);
+    removeFieldButton->setEnabled(true);
+    schemaRestored = true;
+    StartupProfiler::mark("schema restored");
+    markReadyIfDone();
+}
+
+void MainWindow::markReadyIfDone() {
+    if (networkReady && schemaRestored) {
+        StartupProfiler::mark("ready to send");
+    }
 }
 
 void MainWindow::setupUi() {
@@ -84,21 +178,45 @@ void MainWindow::setupUi() {
     buttonLayout->addWidget(cancelButton);
     mainLayout->addLayout(buttonLayout);
 
-    resize(600, 400);
+    mainLayout->addWidget(new QLabel("Batch:", this));
+    batchList = new QListWidget(this);
+    batchList->setObjectName("batchList");
+    batchList->setMaximumHeight(100);
+    mainLayout->addWidget(batchList);
+
+    QHBoxLayout *batchButtonLayout = new QHBoxLayout();
+    addToBatchButton = new QPushButton("Add Table to Batch", this);
+    addToBatchButton->setObjectName("addToBatchButton");
+    clearBatchButton = new QPushButton("Clear Batch", this);
+    clearBatchButton->setObjectName("clearBatchButton");
+    sendBatchButton = new QPushButton("Send Batch", this);
+    sendBatchButton->setObjectName("sendBatchButton");
+    batchButtonLayout->addWidget(addToBatchButton);
+    batchButtonLayout->addWidget(clearBatchButton);
+    batchButtonLayout->addWidget(sendBatchButton);
+    mainLayout->addLayout(batchButtonLayout);
+
+    resize(600, 520);
 }
 
 void MainWindow::addField() {
+    addFieldRow(FieldSpec());
+}
+
+void MainWindow::addFieldRow(const FieldSpec &spec) {
     int row = fieldsTable->rowCount();
     fieldsTable->insertRow(row);
 
-    auto *nameEdit = new QLineEdit(fieldsTable);
+    auto *nameEdit = new QLineEdit(spec.name, fieldsTable);
     fieldsTable->setCellWidget(row, 0, nameEdit);
 
     auto *typeCombo = new QComboBox(fieldsTable);
     typeCombo->addItems({"int", "double", "string", "name"});
+    typeCombo->setCurrentText(spec.type);
     fieldsTable->setCellWidget(row, 1, typeCombo);
 
-    QWidget *paramWidget = createParamsWidget("int", row);
+    // Тип выставлен до подключения сигнала, поэтому виджет параметров строится один раз
+    QWidget *paramWidget = createParamsWidget(typeCombo->currentText(), row, spec);
     fieldsTable->setCellWidget(row, 2, paramWidget);
 
     connect(typeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -120,7 +238,7 @@ void MainWindow::removeSelectedField() {
     }
 }
 
-QWidget* MainWindow::createParamsWidget(const QString& type, int row) {
+QWidget* MainWindow::createParamsWidget(const QString& type, int row, const FieldSpec &values) {
     auto *container = new QWidget(fieldsTable);
     auto *layout = new QHBoxLayout(container);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -128,12 +246,12 @@ QWidget* MainWindow::createParamsWidget(const QString& type, int row) {
     if (type == "int" || type == "double") {
         auto *minSpin = new QSpinBox(container);
         minSpin->setRange(-1000000, 1000000);
-        minSpin->setValue(1);
+        minSpin->setValue(values.min);
         minSpin->setObjectName("min");
 
         auto *maxSpin = new QSpinBox(container);
         maxSpin->setRange(-1000000, 1000000);
-        maxSpin->setValue(100);
+        maxSpin->setValue(values.max);
         maxSpin->setObjectName("max");
 
         layout->addWidget(new QLabel("Min:", container));
@@ -143,7 +261,7 @@ QWidget* MainWindow::createParamsWidget(const QString& type, int row) {
     } else if (type == "string") {
         auto *lengthSpin = new QSpinBox(container);
         lengthSpin->setRange(1, 1000);
-        lengthSpin->setValue(10);
+        lengthSpin->setValue(values.length);
         lengthSpin->setObjectName("length");
 
         layout->addWidget(new QLabel("Length:", container));
@@ -212,22 +330,75 @@ QJsonObject MainWindow::createJsonBody() const {
     return json;
 }
 
-void MainWindow::sendRequest() {
+TableSchema MainWindow::currentSchema() const {
+    TableSchema schema;
+    schema.tableName = tableNameEdit->text();
+    schema.rows = rowsSpinBox->value();
+    schema.outputFile = outputFileEdit->text();
+    schema.fields.reserve(fieldsTable->rowCount());
+
+    for (int row = 0; row < fieldsTable->rowCount(); ++row) {
+        auto *nameEdit = qobject_cast<QLineEdit*>(fieldsTable->cellWidget(row, 0));
+        auto *typeCombo = qobject_cast<QComboBox*>(fieldsTable->cellWidget(row, 1));
+        QWidget *paramsWidget = fieldsTable->cellWidget(row, 2);
+        if (!nameEdit || !typeCombo || !paramsWidget) continue;
+
+        FieldSpec field;
+        field.name = nameEdit->text();
+        field.type = typeCombo->currentText();
+        if (auto *minSpin = paramsWidget->findChild<QSpinBox*>("min")) field.min = minSpin->value();
+        if (auto *maxSpin = paramsWidget->findChild<QSpinBox*>("max")) field.max = maxSpin->value();
+        if (auto *lengthSpin = paramsWidget->findChild<QSpinBox*>("length")) field.length = lengthSpin->value();
+        schema.fields.append(field);
+    }
+    return schema;
+}
+
+void MainWindow::saveSchema() {
+    // До восстановления кэша форма не отражает схему пользователя, а незаполненную форму не сохраняем
+    if (!schemaRestored) return;
+    TableSchema schema = currentSchema();
+    if (schema.tableName.isEmpty() || schema.fields.isEmpty()) return;
+    for (const FieldSpec &field : std::as_const(schema.fields)) {
+        if (field.name.isEmpty()) return;
+    }
+    SchemaCache::save(schema);
+}
+
+bool MainWindow::validateInput() {
+    if (!pendingFields.isEmpty()) {
+        showWarning("Please Wait", "The last used schema is still being restored.");
+        return false;
+    }
     if (tableNameEdit->text().isEmpty()) {
         showWarning("Input Error", "Table name cannot be empty.");
-        return;
+        return false;
     }
     if (fieldsTable->rowCount() == 0) {
         showWarning("Input Error", "At least one field is required.");
-        return;
+        return false;
     }
     for (int row = 0; row < fieldsTable->rowCount(); ++row) {
         auto *nameEdit = qobject_cast<QLineEdit*>(fieldsTable->cellWidget(row, 0));
         if (!nameEdit || nameEdit->text().isEmpty()) {
             showWarning("Input Error", QString("Field name in row %1 cannot be empty.").arg(row + 1));
-            return;
+            return false;
         }
     }
+    return true;
+}
+
+void MainWindow::setRequestInProgress(bool inProgress) {
+    sendButton->setText(inProgress ? "Processing..." : "Send Request");
+    sendButton->setEnabled(!inProgress);
+    sendBatchButton->setEnabled(!inProgress);
+    cancelButton->setVisible(inProgress);
+}
+
+void MainWindow::sendRequest() {
+    if (!validateInput()) {
+        return;
+    }
 
     QJsonObject json = createJsonBody();
     QJsonDocument doc(json);
@@ -236,20 +407,80 @@ void MainWindow::sendRequest() {
     QNetworkRequest request(QUrl("http://localhost:8080/generate"));
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
 
+    saveSchema();
+    startNetwork();
+
     responseData.clear();
     requestSuccessful = false; // Сбрасываем флаг успеха
     emit sendNetworkRequest(request, jsonData);
 
-    sendButton->setText("Processing...");
-    sendButton->setEnabled(false);
-    cancelButton->setVisible(true);
+    setRequestInProgress(true);
+}
+
+void MainWindow::addTableToBatch() {
+    if (!validateInput()) {
+        return;
+    }
+
+    QJsonObject table = createJsonBody();
+    // Части пакетного ответа сохраняются в одну директорию по имени файла
+    QString outputFile = QFileInfo(table["output_file"].toString()).fileName();
+    if (outputFile.isEmpty()) {
+        showWarning("Input Error", "Output file cannot be empty.");
+        return;
+    }
+    for (const QJsonValue &value : batchTables) {
+        if (QFileInfo(value.toObject()["output_file"].toString()).fileName() == outputFile) {
+            showWarning("Input Error", QString("Output file %1 is already used in the batch.").arg(outputFile));
+            return;
+        }
+    }
+
+    batchTables.append(table);
+    batchList->addItem(QString("%1: %2 rows, %3 fields -> %4")
+                           .arg(table["table_name"].toString())
+                           .arg(table["rows"].toInt())
+                           .arg(table["fields"].toArray().size())
+                           .arg(outputFile));
+}
+
+void MainWindow::clearBatch() {
+    batchTables = QJsonArray();
+    batchList->clear();
+}
+
+void MainWindow::sendBatchRequest() {
+    if (batchTables.isEmpty()) {
+        showWarning("Input Error", "Add at least one table to the batch.");
+        return;
+    }
+
+    QString outputDir = getExistingDirectory("Select Output Directory", QString());
+    if (outputDir.isEmpty()) {
+        return;
+    }
+
+    QJsonObject json;
+    json["tables"] = batchTables;
+    QByteArray jsonData = QJsonDocument(json).toJson();
+
+    QNetworkRequest request(QUrl("http://localhost:8080/generate/batch"));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    request.setRawHeader("Accept", "multipart/mixed");
+
+    saveSchema();
+    startNetwork();
+
+    responseData.clear();
+    requestSuccessful = false;
+    emit sendNetworkBatchRequest(request, jsonData, outputDir);
+
+    setRequestInProgress(true);
 }
 
 void MainWindow::cancelRequest() {
     emit cancelNetworkRequest();
-    sendButton->setText("Send Request");
-    sendButton->setEnabled(true);
-    cancelButton->setVisible(false);
+    setRequestInProgress(false);
     requestSuccessful = false; // Запрос неуспешен
     responseData.clear();
     showInformation("Cancelled", "Request has been cancelled.");
@@ -261,9 +492,7 @@ void MainWindow::onDataReceived(const QByteArray &data) {
 }
 
 void MainWindow::onRequestFinished() {
-    sendButton->setText("Send Request");
-    sendButton->setEnabled(true);
-    cancelButton->setVisible(false);
+    setRequestInProgress(false);
 
     if (!requestSuccessful || responseData.isEmpty()) {
         // Не показываем QFileDialog при ошибке или отмене
@@ -289,10 +518,12 @@ void MainWindow::onRequestFinished() {
     responseData.clear();
 }
 
+void MainWindow::onBatchFinished(const QStringList &files) {
+    showInformation("Success", QString("Saved %1 CSV files from the batch.").arg(files.size()));
+}
+
 void MainWindow::onErrorOccurred(const QString &error) {
-    sendButton->setText("Send Request");
-    sendButton->setEnabled(true);
-    cancelButton->setVisible(false);
+    setRequestInProgress(false);
     requestSuccessful = false; // Запрос неуспешен
     showCritical("Network Error", error);
     responseData.clear();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "network_worker.h"
+#include "schema_cache.h"
 
 #include <QMainWindow>
 #include <QTableWidget>
@@ -11,6 +12,8 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QThread>
+#include <QListWidget>
+#include <QJsonArray>
 
 class QNetworkRequest;
 
@@ -23,9 +26,18 @@ public:
     QJsonObject createJsonBody() const;
 
 protected:
+    void paintEvent(QPaintEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
+
+    virtual NetworkWorker* createNetworkWorker() {
+        return new NetworkWorker();
+    }
     virtual QString getSaveFileName(const QString& caption, const QString& dir, const QString& filter) {
         return QFileDialog::getSaveFileName(this, caption, dir, filter);
     }
+    virtual QString getExistingDirectory(const QString& caption, const QString& dir) {
+        return QFileDialog::getExistingDirectory(this, caption, dir);
+    }
     virtual void showWarning(const QString& title, const QString& text) {
         QMessageBox::warning(this, title, text);
     }
@@ -38,6 +50,7 @@ protected:
 
     signals:
         void sendNetworkRequest(const QNetworkRequest &request, const QByteArray &data);
+    void sendNetworkBatchRequest(const QNetworkRequest &request, const QByteArray &data, const QString &outputDir);
     void cancelNetworkRequest();
 
     private slots:
@@ -45,10 +58,17 @@ protected:
     void removeSelectedField();
     void sendRequest();
     void cancelRequest();
+    void addTableToBatch();
+    void clearBatch();
+    void sendBatchRequest();
     void onDataReceived(const QByteArray &data);
     void onRequestFinished();
+    void onBatchFinished(const QStringList &files);
     void onErrorOccurred(const QString &error);
     void updateFieldParams(int row);
+    void onFirstFrame();
+    void onNetworkReady();
+    void restoreNextFields();
 
 private:
     QLineEdit *tableNameEdit;
@@ -59,11 +79,28 @@ private:
     QPushButton *removeFieldButton;
     QPushButton *sendButton;
     QPushButton *cancelButton;
+    QListWidget *batchList;
+    QPushButton *addToBatchButton;
+    QPushButton *clearBatchButton;
+    QPushButton *sendBatchButton;
+    QJsonArray batchTables;
     QThread *networkThread;
     NetworkWorker *worker;
     QByteArray responseData;
     bool requestSuccessful; // Флаг для отслеживания успешности запроса
+    bool firstFramePainted;
+    bool networkReady;
+    bool schemaRestored;
+    QVector<FieldSpec> pendingFields; // Поля кэшированной схемы, ещё не добавленные в таблицу
 
     void setupUi();
-    QWidget* createParamsWidget(const QString& type, int row);
+    void startNetwork();
+    void saveSchema();
+    void restoreSchema();
+    void markReadyIfDone();
+    void addFieldRow(const FieldSpec &spec);
+    TableSchema currentSchema() const;
+    bool validateInput();
+    void setRequestInProgress(bool inProgress);
+    QWidget* createParamsWidget(const QString& type, int row, const FieldSpec &values = FieldSpec());
 };
\ No newline at end of file
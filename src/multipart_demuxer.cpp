@@ -0,0 +1,184 @@
+#include "multipart_demuxer.h"
+#include <QDir>
+#include <QFileInfo>
+
+namespace {
+constexpr qsizetype kMaxHeaderSize = 64 * 1024;
+
+QByteArray headerParameter(const QByteArray &value, const QByteArray &name) {
+    for (const QByteArray &rawParam : value.split(';')) {
+        QByteArray param = rawParam.trimmed();
+        int eq = param.indexOf('=');
+        if (eq < 0 || param.left(eq).trimmed().toLower() != name) continue;
+        QByteArray result = param.mid(eq + 1).trimmed();
+        if (result.size() >= 2 && result.startsWith('"') && result.endsWith('"')) {
+            result = result.mid(1, result.size() - 2);
+        }
+        return result;
+    }
+    return QByteArray();
+}
+}
+
+// m_buffer начинается с CRLF: первый разделитель может стоять в самом начале тела
+MultipartDemuxer::MultipartDemuxer(const QByteArray &boundary, const QString &outputDir)
+    : m_delimiter("\r\n--" + boundary), m_outputDir(outputDir), m_buffer("\r\n"), m_state(State::Preamble) {}
+
+MultipartDemuxer::~MultipartDemuxer() {
+    if (m_state != State::Done) {
+        discard();
+    }
+}
+
+QByteArray MultipartDemuxer::boundaryFromContentType(const QByteArray &contentType) {
+    if (!contentType.trimmed().toLower().startsWith("multipart/")) {
+        return QByteArray();
+    }
+    return headerParameter(contentType, "boundary");
+}
+
+bool MultipartDemuxer::feed(const QByteArray &data) {
+    if (m_state == State::Failed) return false;
+    if (m_state == State::Done) return true;
+    m_buffer.append(data);
+
+    while (true) {
+        switch (m_state) {
+        case State::Preamble: {
+            qsizetype idx = m_buffer.indexOf(m_delimiter);
+            if (idx < 0) {
+                m_buffer.remove(0, qMax<qsizetype>(0, m_buffer.size() - m_delimiter.size() + 1));
+                return true;
+            }
+            m_buffer.remove(0, idx + m_delimiter.size());
+            m_state = State::AfterDelimiter;
+            break;
+        }
+        case State::AfterDelimiter:
+            if (m_buffer.size() < 2) return true;
+            if (m_buffer.startsWith("--")) {
+                m_buffer.clear();
+                m_state = State::Done;
+                return true;
+            }
+            if (!m_buffer.startsWith("\r\n")) {
+                return fail("Malformed multipart delimiter in batch response.");
+            }
+            m_buffer.remove(0, 2);
+            m_state = State::Headers;
+            break;
+        case State::Headers: {
+            qsizetype idx = m_buffer.indexOf("\r\n\r\n");
+            if (idx < 0) {
+                if (m_buffer.size() > kMaxHeaderSize) {
+                    return fail("Multipart part headers are too large.");
+                }
+                return true;
+            }
+            if (!openPart(m_buffer.left(idx))) return false;
+            m_buffer.remove(0, idx + 4);
+            m_state = State::Body;
+            break;
+        }
+        case State::Body: {
+            qsizetype idx = m_buffer.indexOf(m_delimiter);
+            if (idx < 0) {
+                // Хвост буфера может оказаться началом разделителя — придерживаем его
+                qsizetype safe = m_buffer.size() - m_delimiter.size() + 1;
+                if (safe > 0) {
+                    if (!writeBody(m_buffer.constData(), safe)) return false;
+                    m_buffer.remove(0, safe);
+                }
+                return true;
+            }
+            if (!writeBody(m_buffer.constData(), idx) || !closePart()) return false;
+            m_buffer.remove(0, idx + m_delimiter.size());
+            m_state = State::AfterDelimiter;
+            break;
+        }
+        case State::Done:
+            return true;
+        case State::Failed:
+            return false;
+        }
+    }
+}
+
+bool MultipartDemuxer::finish() {
+    if (m_state == State::Failed) return false;
+    if (m_state != State::Done) {
+        return fail("Batch response ended unexpectedly.");
+    }
+    return true;
+}
+
+// Частично сохранённый пакет не оставляем: иначе повторная отправка упрётся в уже существующие файлы
+void MultipartDemuxer::discard() {
+    if (m_file.isOpen()) {
+        m_file.close();
+        m_file.remove();
+    }
+    for (const QString &fileName : std::as_const(m_files)) {
+        QFile::remove(fileName);
+    }
+    m_files.clear();
+}
+
+bool MultipartDemuxer::openPart(const QByteArray &headers) {
+    QByteArray fileName;
+    for (const QByteArray &line : headers.split('\n')) {
+        int colon = line.indexOf(':');
+        if (colon < 0) continue;
+        if (line.left(colon).trimmed().toLower() != "content-disposition") continue;
+        QByteArray value = line.mid(colon + 1).trimmed();
+        fileName = headerParameter(value, "filename");
+        if (fileName.isEmpty()) {
+            fileName = headerParameter(value, "name");
+        }
+    }
+
+    // Имя из ответа сервера не должно выводить за пределы выбранной директории
+    QString name = QFileInfo(QString::fromUtf8(fileName)).fileName();
+    if (name.isEmpty() || name == "." || name == "..") {
+        return fail(QString("Part %1 of the batch response has no file name.").arg(m_files.size() + 1));
+    }
+
+    if (m_names.contains(name)) {
+        return fail(QString("Batch response contains file %1 more than once.").arg(name));
+    }
+    m_names.insert(name);
+
+    // Существующие файлы не перезаписываем: в отличие от одиночного запроса, диалог тут не спрашивает
+    m_file.setFileName(QDir(m_outputDir).filePath(name));
+    if (m_file.exists()) {
+        return fail(QString("File %1 already exists in the output directory.").arg(name));
+    }
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+        return fail("Failed to save CSV file: " + m_file.errorString());
+    }
+    return true;
+}
+
+bool MultipartDemuxer::writeBody(const char *data, qsizetype size) {
+    if (size > 0 && m_file.write(data, size) != size) {
+        return fail("Failed to save CSV file: " + m_file.errorString());
+    }
+    return true;
+}
+
+bool MultipartDemuxer::closePart() {
+    m_file.close();
+    if (m_file.error() != QFileDevice::NoError) {
+        return fail("Failed to save CSV file: " + m_file.errorString());
+    }
+    m_files.append(m_file.fileName());
+    return true;
+}
+
+bool MultipartDemuxer::fail(const QString &error) {
+    discard();
+    m_error = error;
+    m_buffer.clear();
+    m_state = State::Failed;
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Потоковый разбор ответа multipart/mixed: каждая часть пишется в отдельный файл
+// в outputDir по мере поступления данных, без накопления всего ответа в памяти.
+// Если разбор не дошёл до конца, все созданные файлы удаляются.
+class MultipartDemuxer {
+public:
+    MultipartDemuxer(const QByteArray &boundary, const QString &outputDir);
+    ~MultipartDemuxer();
+
+    static QByteArray boundaryFromContentType(const QByteArray &contentType);
+
+    bool feed(const QByteArray &data);
+    bool finish();
+    void discard();
+
+    QStringList writtenFiles() const { return m_files; }
+    QString errorString() const { return m_error; }
+
+private:
+    enum class State { Preamble, AfterDelimiter, Headers, Body, Done, Failed };
+
+    bool openPart(const QByteArray &headers);
+    bool writeBody(const char *data, qsizetype size);
+    bool closePart();
+    bool fail(const QString &error);
+
+    QByteArray m_delimiter;
+    QString m_outputDir;
+    QByteArray m_buffer;
+    State m_state;
+    QFile m_file;
+    QStringList m_files;
+    QSet<QString> m_names;
+    QString m_error;
+};
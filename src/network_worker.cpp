@@ -1,8 +1,6 @@
 #include "network_worker.h"
 
-NetworkWorker::NetworkWorker(QObject *parent) : QObject(parent) {
-    m_qnam.reset(new QNetworkAccessManager(this));
-}
+NetworkWorker::NetworkWorker(QObject *parent) : QObject(parent) {}
 
 NetworkWorker::~NetworkWorker() {
     if (m_reply) {
@@ -10,13 +8,41 @@ NetworkWorker::~NetworkWorker() {
     }
 }
 
+// QNetworkAccessManager создаётся уже в сетевом потоке, а не при конструировании окна
+void NetworkWorker::initialize() {
+    ensureManager();
+    emit ready();
+}
+
+void NetworkWorker::ensureManager() {
+    if (!m_qnam) {
+        m_qnam.reset(new QNetworkAccessManager(this));
+    }
+}
+
+void NetworkWorker::setNetworkManager(QNetworkAccessManager *manager) {
+    manager->setParent(this);
+    m_qnam.reset(manager);
+}
+
 void NetworkWorker::processRequest(const QNetworkRequest &request, const QByteArray &data) {
+    ensureManager();
     m_reply.reset();
+    m_demuxer.reset();
+    m_batchOutputDir.clear();
+    m_batchError.clear();
+    m_batchMode = false;
     m_reply.reset(m_qnam->post(request, data));
     connect(m_reply.get(), &QNetworkReply::readyRead, this, &NetworkWorker::onReadyRead);
     connect(m_reply.get(), &QNetworkReply::finished, this, &NetworkWorker::onFinished);
 }
 
+void NetworkWorker::processBatchRequest(const QNetworkRequest &request, const QByteArray &data, const QString &outputDir) {
+    processRequest(request, data);
+    m_batchOutputDir = outputDir;
+    m_batchMode = true;
+}
+
 void NetworkWorker::cancelRequest() {
     if (m_reply) {
         m_reply->abort();
@@ -24,16 +50,67 @@ void NetworkWorker::cancelRequest() {
 }
 
 void NetworkWorker::onReadyRead() {
-    emit dataReceived(m_reply->readAll());
+    if (!m_batchMode) {
+        emit dataReceived(m_reply->readAll());
+        return;
+    }
+    if (!m_batchError.isEmpty()) {
+        m_reply->readAll();
+        return;
+    }
+    // Тело ответа с ошибкой HTTP не разбираем — об ошибке сообщит onFinished()
+    if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() >= 400) {
+        m_reply->readAll();
+        return;
+    }
+    if (!m_demuxer) {
+        QByteArray boundary = MultipartDemuxer::boundaryFromContentType(m_reply->rawHeader("Content-Type"));
+        if (boundary.isEmpty()) {
+            failBatch("Batch response is not a multipart body.");
+            return;
+        }
+        m_demuxer.reset(new MultipartDemuxer(boundary, m_batchOutputDir));
+    }
+    if (!m_demuxer->feed(m_reply->readAll())) {
+        failBatch(m_demuxer->errorString());
+    }
 }
 
 void NetworkWorker::onFinished() {
+    if (m_batchMode && !m_batchError.isEmpty()) {
+        emit errorOccurred(m_batchError);
+        emit finished();
+        return;
+    }
     if (m_reply->error() == QNetworkReply::OperationCanceledError) {
+        if (m_demuxer) {
+            m_demuxer->discard();
+        }
+        m_demuxer.reset();
         emit finished();
         return;
     }
     if (m_reply->error() != QNetworkReply::NoError) {
+        if (m_demuxer) {
+            m_demuxer->discard();
+        }
+        m_demuxer.reset();
         emit errorOccurred(m_reply->errorString());
+    } else if (m_batchMode) {
+        if (!m_demuxer) {
+            emit errorOccurred("Batch response is empty.");
+        } else if (!m_demuxer->finish()) {
+            emit errorOccurred(m_demuxer->errorString());
+        } else {
+            emit batchFinished(m_demuxer->writtenFiles());
+        }
+        m_demuxer.reset();
     }
     emit finished();
-}
\ No newline at end of file
+}
+
+void NetworkWorker::failBatch(const QString &error) {
+    m_batchError = error;
+    m_demuxer.reset();
+    m_reply->abort();
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "multipart_demuxer.h"
+
 #include <QObject>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -11,13 +13,18 @@ class NetworkWorker : public QObject {
 public:
     NetworkWorker(QObject *parent = nullptr);
     ~NetworkWorker();
+    void setNetworkManager(QNetworkAccessManager *manager);
 
     public slots:
-        void processRequest(const QNetworkRequest &request, const QByteArray &data);
+        void initialize();
+    void processRequest(const QNetworkRequest &request, const QByteArray &data);
+    void processBatchRequest(const QNetworkRequest &request, const QByteArray &data, const QString &outputDir);
     void cancelRequest();
 
     signals:
-        void dataReceived(const QByteArray &data);
+        void ready();
+    void dataReceived(const QByteArray &data);
+    void batchFinished(const QStringList &files);
     void finished();
     void errorOccurred(const QString &error);
 
@@ -28,4 +35,11 @@ public:
 private:
     QScopedPointer<QNetworkAccessManager, QScopedPointerDeleter<QNetworkAccessManager>> m_qnam;
     QScopedPointer<QNetworkReply, QScopedPointerDeleter<QNetworkReply>> m_reply;
-};
\ No newline at end of file
+    QScopedPointer<MultipartDemuxer> m_demuxer;
+    QString m_batchOutputDir;
+    QString m_batchError;
+    bool m_batchMode = false;
+
+    void ensureManager();
+    void failBatch(const QString &error);
+};
@@ -0,0 +1,82 @@
+#include "schema_cache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+
+namespace {
+constexpr quint32 kMagic = 0x51435343; // "QCSC"
+constexpr quint16 kVersion = 1;
+const QStringList kFieldTypes = {"int", "double", "string", "name"};
+}
+
+QString SchemaCache::defaultPath() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("last_schema.bin");
+}
+
+bool SchemaCache::save(const TableSchema &schema, const QString &path) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kMagic << kVersion;
+    out << schema.tableName << qint32(schema.rows) << schema.outputFile;
+    out << quint32(schema.fields.size());
+    for (const FieldSpec &field : schema.fields) {
+        out << field.name << quint8(qMax(0, kFieldTypes.indexOf(field.type)))
+            << qint32(field.min) << qint32(field.max) << qint32(field.length);
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool SchemaCache::load(TableSchema *schema, const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        return false;
+    }
+
+    TableSchema result;
+    qint32 rows = 0;
+    quint32 count = 0;
+    in >> result.tableName >> rows >> result.outputFile >> count;
+    if (in.status() != QDataStream::Ok || count > quint32(file.size())) {
+        return false;
+    }
+    result.rows = rows;
+    result.fields.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        FieldSpec field;
+        quint8 type = 0;
+        qint32 min = 0, max = 0, length = 0;
+        in >> field.name >> type >> min >> max >> length;
+        if (type >= kFieldTypes.size()) {
+            return false;
+        }
+        field.type = kFieldTypes.at(type);
+        field.min = min;
+        field.max = max;
+        field.length = length;
+        result.fields.append(field);
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+    *schema = result;
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+struct FieldSpec {
+    QString name;
+    QString type = "int";
+    int min = 1;
+    int max = 100;
+    int length = 10;
+};
+
+struct TableSchema {
+    QString tableName;
+    int rows = 10;
+    QString outputFile;
+    QVector<FieldSpec> fields;
+};
+
+// Компактный бинарный кэш последней схемы: читается целиком за один проход,
+// без разбора JSON, чтобы большие схемы восстанавливались при старте быстро.
+class SchemaCache {
+public:
+    static QString defaultPath();
+    static bool save(const TableSchema &schema, const QString &path = defaultPath());
+    static bool load(TableSchema *schema, const QString &path = defaultPath());
+};
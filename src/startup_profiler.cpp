@@ -0,0 +1,17 @@
+#include "startup_profiler.h"
+#include <QDebug>
+
+QElapsedTimer StartupProfiler::s_timer;
+qint64 StartupProfiler::s_lastMark = 0;
+
+void StartupProfiler::start() {
+    s_timer.start();
+    s_lastMark = 0;
+}
+
+void StartupProfiler::mark(const char *phase) {
+    if (!s_timer.isValid()) return;
+    qint64 now = s_timer.elapsed();
+    qInfo().noquote() << QString("startup: %1 at %2 ms (+%3 ms)").arg(phase).arg(now).arg(now - s_lastMark);
+    s_lastMark = now;
+}
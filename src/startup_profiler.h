@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QElapsedTimer>
+
+// Замеры фаз запуска: от старта процесса до первого кадра и готовности к отправке.
+class StartupProfiler {
+public:
+    static void start();
+    static void mark(const char *phase);
+
+private:
+    static QElapsedTimer s_timer;
+    static qint64 s_lastMark;
+};
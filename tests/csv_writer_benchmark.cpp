@@ -0,0 +1,75 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include "../src/csv_writer.h"
+
+// Пропускная способность CsvWriter на одном ядре: выводит GB/s для каждого типа колонок.
+class CsvWriterBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {
+        QRandomGenerator generator(42);
+        ints.resize(kRows);
+        doubles.resize(kRows);
+        strings.fill('x', kRows * kStringWidth);
+        for (qsizetype i = 0; i < kRows; ++i) {
+            ints[i] = qint64(generator.generate64()) >> generator.bounded(64);
+            doubles[i] = generator.generateDouble() * 2e6 - 1e6;
+            // Строки разной длины, каждая двадцатая требует кавычек
+            qsizetype length = 4 + generator.bounded(kStringWidth - 4);
+            char *slot = strings.data() + i * kStringWidth;
+            if (length < kStringWidth) slot[length] = '\0';
+            if (i % 20 == 0) slot[1] = ',';
+        }
+    }
+
+    void benchmarkInts() {
+        run({CsvColumn::fromInts(ints.constData())});
+    }
+
+    void benchmarkDoubles() {
+        run({CsvColumn::fromDoubles(doubles.constData())});
+    }
+
+    void benchmarkFixedStrings() {
+        run({CsvColumn::fromFixedStrings(strings.constData(), kStringWidth)});
+    }
+
+    void benchmarkMixedRow() {
+        run({CsvColumn::fromInts(ints.constData()), CsvColumn::fromDoubles(doubles.constData()),
+             CsvColumn::fromFixedStrings(strings.constData(), kStringWidth)});
+    }
+
+private:
+    static constexpr qsizetype kRows = 1000000;
+    static constexpr int kStringWidth = 32;
+    static constexpr int kIterations = 10;
+
+    QVector<qint64> ints;
+    QVector<double> doubles;
+    QByteArray strings;
+
+    void run(const QVector<CsvColumn> &columns) {
+        CsvWriter writer;
+        // Прогрев: буфер дорастает до нужного размера и дальше не перевыделяется
+        QVERIFY(writer.writeBatch(columns, kRows));
+
+        qint64 bytes = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < kIterations; ++i) {
+            writer.clear();
+            QVERIFY(writer.writeBatch(columns, kRows));
+            bytes += writer.buffer().size();
+        }
+        qint64 nsecs = qMax<qint64>(1, timer.nsecsElapsed());
+
+        double bytesPerSecond = double(bytes) * 1e9 / double(nsecs);
+        qInfo().noquote() << QString("%1: %2 GB/s").arg(QTest::currentTestFunction()).arg(bytesPerSecond / 1e9, 0, 'f', 2);
+        QTest::setBenchmarkResult(bytesPerSecond, QTest::BytesPerSecond);
+    }
+};
+
+QTEST_MAIN(CsvWriterBenchmark)
+#include "csv_writer_benchmark.moc"
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QRandomGenerator>
+#include <limits>
+#include "../src/csv_writer.h"
+
+class CsvWriterTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testIntegers() {
+        QVector<qint64> values = {0, 7, 10, 99, 100, -1, -100500,
+                                  std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max()};
+        CsvWriter writer;
+        QVERIFY(writer.writeBatch({CsvColumn::fromInts(values.constData())}, values.size()));
+
+        QByteArray expected;
+        for (qint64 value : values) {
+            expected += QByteArray::number(value) + '\n';
+        }
+        QCOMPARE(writer.buffer().toByteArray(), expected);
+    }
+
+    void testDoublesRoundTrip() {
+        QVector<double> values = {0.1, -2.5, 1.0 / 3, 1e300, 5e-324, 123.456};
+        for (int i = 0; i < 10000; ++i) {
+            values.append(QRandomGenerator::global()->generateDouble() * 1e6 - 5e5);
+        }
+        CsvWriter writer;
+        QVERIFY(writer.writeBatch({CsvColumn::fromDoubles(values.constData())}, values.size()));
+
+        QList<QByteArray> lines = writer.buffer().toByteArray().split('\n');
+        QCOMPARE(lines.size(), values.size() + 1);
+        for (qsizetype i = 0; i < values.size(); ++i) {
+            bool ok = false;
+            QCOMPARE(lines.at(i).toDouble(&ok), values.at(i));
+            QVERIFY(ok);
+        }
+    }
+
+    void testFixedStringsQuoting() {
+        const int width = 24;
+        const QList<QByteArray> values = {"plain", "with,comma", "say \"hi\"", "multi\nline", "a long value without specials"};
+        QByteArray packed;
+        for (const QByteArray &value : values) {
+            packed += value.leftJustified(width, '\0', true);
+        }
+        QVector<qint64> ids = {1, 2, 3, 4, 5};
+        CsvWriter writer;
+        writer.writeHeader({"id", "value"});
+        QVERIFY(writer.writeBatch({CsvColumn::fromInts(ids.constData()), CsvColumn::fromFixedStrings(packed.constData(), width)}, 5));
+
+        QByteArray expected = "id,value\n"
+                              "1,plain\n"
+                              "2,\"with,comma\"\n"
+                              "3,\"say \"\"hi\"\"\"\n"
+                              "4,\"multi\nline\"\n"
+                              "5,a long value without spe\n";
+        QCOMPARE(writer.buffer().toByteArray(), expected);
+    }
+
+    void testRejectsInvalidColumns() {
+        const char values[] = "abcd";
+        CsvColumn column;
+        column.type = CsvColumn::Type::FixedString;
+        column.strings = values;
+        column.width = -4;
+        CsvWriter writer;
+        QVERIFY(!writer.writeBatch({column}, 1));
+        QVERIFY(!writer.writeBatch({CsvColumn::fromInts(nullptr)}, 1));
+        QCOMPARE(writer.buffer().size(), qsizetype(0));
+    }
+
+    void testFlushesToDevice() {
+        QVector<qint64> values(100000);
+        for (qsizetype i = 0; i < values.size(); ++i) {
+            values[i] = i;
+        }
+        QBuffer device;
+        QVERIFY(device.open(QIODevice::WriteOnly));
+        CsvWriter writer(&device, 4096);
+        QVERIFY(writer.writeBatch({CsvColumn::fromInts(values.constData())}, values.size()));
+        QVERIFY(writer.buffer().size() < 4096 + 64 * 1024);
+        QVERIFY(writer.flush());
+        QCOMPARE(writer.buffer().size(), qsizetype(0));
+        QVERIFY(device.data().startsWith("0\n1\n2\n"));
+        QVERIFY(device.data().endsWith("99999\n"));
+    }
+};
+
+QTEST_MAIN(CsvWriterTests)
+#include "csv_writer_test.moc"
\ No newline at end of file
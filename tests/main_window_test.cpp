@@ -1,6 +1,10 @@
 #include <QtTest/QtTest>
 #include <QLabel>
+#include <QTemporaryDir>
 #include "../src/main_window.h"
+#include "../src/network_worker.h"
+#include "../src/multipart_demuxer.h"
+#include "../src/schema_cache.h"
 
 class MockNetworkReply : public QNetworkReply {
 public:
@@ -21,6 +25,15 @@ public:
     qint64 bytesAvailable() const override {
         return rawData.size() + QIODevice::bytesAvailable();
     }
+    void setContentType(const QByteArray &contentType) {
+        setRawHeader("Content-Type", contentType);
+    }
+    void setNetworkError(NetworkError code, const QString &text) {
+        setError(code, text);
+    }
+    void emitReadyRead() {
+        emit readyRead();
+    }
     void emitFinished() {
         emit finished();
     }
@@ -53,7 +66,7 @@ public:
     }
     QNetworkRequest lastRequest;
     QByteArray lastData;
-    QList<MockNetworkReply*> replies;
+    QList<QPointer<MockNetworkReply>> replies; // Ответ может удалить и сам NetworkWorker
 };
 
 class TestMainWindow : public MainWindow {
@@ -68,21 +81,34 @@ public:
     void showCritical(const QString& title, const QString& text) override {
         lastMessage = {title, text, "critical"};
     }
+    QString getExistingDirectory(const QString&, const QString&) override {
+        return outputDir;
+    }
     void showInformation(const QString& title, const QString& text) override {
         lastMessage = {title, text, "information"};
     }
+    NetworkWorker* createNetworkWorker() override {
+        createdWorker = MainWindow::createNetworkWorker();
+        return createdWorker;
+    }
     struct Message {
         QString title;
         QString text;
         QString type;
     };
     Message lastMessage;
+    QString outputDir;
+    NetworkWorker *createdWorker = nullptr;
 };
 
 class TestMainWindowTests : public QObject {
     Q_OBJECT
 
 private slots:
+    void initTestCase() {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
     void cleanup() {
         QCoreApplication::processEvents();
     }
@@ -238,7 +264,6 @@ private slots:
     void testInputValidation() {
         TestMainWindow w;
         MockNetworkAccessManager *mockManager = new MockNetworkAccessManager(&w);
-        w.setNetworkManager(mockManager);
 
         QPushButton *sendButton = w.findChild<QPushButton*>("sendButton");
         QLineEdit *tableNameEdit = w.findChild<QLineEdit*>("tableNameEdit");
@@ -275,8 +300,374 @@ private slots:
         delete mockManager;
     }
 
+    void testBatchQueue() {
+        TestMainWindow w;
+        QPushButton *addFieldButton = w.findChild<QPushButton*>("addFieldButton");
+        QPushButton *addToBatchButton = w.findChild<QPushButton*>("addToBatchButton");
+        QPushButton *clearBatchButton = w.findChild<QPushButton*>("clearBatchButton");
+        QPushButton *sendBatchButton = w.findChild<QPushButton*>("sendBatchButton");
+        QListWidget *batchList = w.findChild<QListWidget*>("batchList");
+        QTableWidget *fieldsTable = w.findChild<QTableWidget*>("fieldsTable");
+        QLineEdit *tableNameEdit = w.findChild<QLineEdit*>("tableNameEdit");
+        QLineEdit *outputFileEdit = w.findChild<QLineEdit*>("outputFileEdit");
+        QVERIFY2(batchList, "Batch QListWidget not found");
+        QVERIFY2(addToBatchButton && clearBatchButton && sendBatchButton, "Batch buttons not found");
+
+        QTest::mouseClick(sendBatchButton, Qt::LeftButton);
+        QCOMPARE(w.lastMessage.text, QString("Add at least one table to the batch."));
+
+        QTest::mouseClick(addFieldButton, Qt::LeftButton);
+        qobject_cast<QLineEdit*>(fieldsTable->cellWidget(0, 0))->setText("id");
+        QTest::mouseClick(addToBatchButton, Qt::LeftButton);
+        QCOMPARE(batchList->count(), 1);
+
+        w.lastMessage = {};
+        QTest::mouseClick(addToBatchButton, Qt::LeftButton);
+        QCOMPARE(batchList->count(), 1);
+        QCOMPARE(w.lastMessage.text, QString("Output file output.csv is already used in the batch."));
+
+        tableNameEdit->setText("orders");
+        outputFileEdit->setText("orders.csv");
+        QTest::mouseClick(addToBatchButton, Qt::LeftButton);
+        QCOMPARE(batchList->count(), 2);
+
+        QTest::mouseClick(clearBatchButton, Qt::LeftButton);
+        QCOMPARE(batchList->count(), 0);
+    }
+
+    void testMultipartDemuxer() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        QByteArray contentType = "multipart/mixed; boundary=\"b0undary\"";
+        QByteArray boundary = MultipartDemuxer::boundaryFromContentType(contentType);
+        QCOMPARE(boundary, QByteArray("b0undary"));
+        QVERIFY(MultipartDemuxer::boundaryFromContentType("text/csv").isEmpty());
+
+        QByteArray body =
+            "--b0undary\r\n"
+            "Content-Type: text/csv\r\n"
+            "Content-Disposition: attachment; filename=\"users.csv\"\r\n\r\n"
+            "id,name\r\n1,Alice\r\n"
+            "\r\n--b0undary\r\n"
+            "Content-Disposition: attachment; filename=\"../orders.csv\"\r\n\r\n"
+            "id\r\n7"
+            "\r\n--b0undary--\r\n";
+
+        // Подаём тело мелкими кусками, чтобы разделитель рвался между чанками
+        MultipartDemuxer demuxer(boundary, dir.path());
+        for (int i = 0; i < body.size(); i += 5) {
+            QVERIFY(demuxer.feed(body.mid(i, 5)));
+        }
+        QVERIFY(demuxer.finish());
+        QCOMPARE(demuxer.writtenFiles().size(), 2);
+
+        QFile users(dir.filePath("users.csv"));
+        QVERIFY(users.open(QIODevice::ReadOnly));
+        QCOMPARE(users.readAll(), QByteArray("id,name\r\n1,Alice\r\n"));
+        QFile orders(dir.filePath("orders.csv"));
+        QVERIFY(orders.open(QIODevice::ReadOnly));
+        QCOMPARE(orders.readAll(), QByteArray("id\r\n7"));
+
+        // Повторный ответ в ту же директорию не должен затирать уже сохранённые файлы
+        MultipartDemuxer overwrite(boundary, dir.path());
+        QVERIFY(!overwrite.feed(body));
+        QCOMPARE(overwrite.errorString(), QString("File users.csv already exists in the output directory."));
+        QVERIFY(users.seek(0));
+        QCOMPARE(users.readAll(), QByteArray("id,name\r\n1,Alice\r\n"));
+
+        QTemporaryDir duplicateDir;
+        QVERIFY(duplicateDir.isValid());
+        QByteArray duplicateBody = body;
+        duplicateBody.replace("../orders.csv", "users.csv");
+        MultipartDemuxer duplicate(boundary, duplicateDir.path());
+        QVERIFY(!duplicate.feed(duplicateBody));
+        QCOMPARE(duplicate.errorString(), QString("Batch response contains file users.csv more than once."));
+        QVERIFY(QDir(duplicateDir.path()).isEmpty());
+
+        QTemporaryDir truncatedDir;
+        QVERIFY(truncatedDir.isValid());
+        MultipartDemuxer truncated(boundary, truncatedDir.path());
+        QVERIFY(truncated.feed(body.left(body.indexOf("id\r\n7"))));
+        QVERIFY(!truncated.finish());
+        QCOMPARE(truncated.errorString(), QString("Batch response ended unexpectedly."));
+        QVERIFY(QDir(truncatedDir.path()).isEmpty());
+    }
+
+    void testSchemaCacheRoundTrip() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString path = dir.filePath("schema.bin");
+
+        TableSchema schema;
+        schema.tableName = "orders";
+        schema.rows = 500;
+        schema.outputFile = "orders.csv";
+        for (int i = 0; i < 500; ++i) {
+            FieldSpec field;
+            field.name = QString("field_%1").arg(i);
+            field.type = QStringList{"int", "double", "string", "name"}.at(i % 4);
+            field.min = -i;
+            field.max = i * 10;
+            field.length = i % 100 + 1;
+            schema.fields.append(field);
+        }
+        QVERIFY(SchemaCache::save(schema, path));
+
+        TableSchema loaded;
+        QVERIFY(SchemaCache::load(&loaded, path));
+        QCOMPARE(loaded.tableName, schema.tableName);
+        QCOMPARE(loaded.rows, schema.rows);
+        QCOMPARE(loaded.outputFile, schema.outputFile);
+        QCOMPARE(loaded.fields.size(), schema.fields.size());
+        QCOMPARE(loaded.fields.at(7).name, QString("field_7"));
+        QCOMPARE(loaded.fields.at(7).type, QString("name"));
+        QCOMPARE(loaded.fields.at(7).min, -7);
+        QCOMPARE(loaded.fields.at(7).max, 70);
+
+        QFile corrupted(path);
+        QVERIFY(corrupted.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        corrupted.write("not a schema");
+        corrupted.close();
+        QVERIFY(!SchemaCache::load(&loaded, path));
+        QVERIFY(!SchemaCache::load(&loaded, dir.filePath("missing.bin")));
+    }
+
+    void testLazyNetworkStartup() {
+        QFile::remove(SchemaCache::defaultPath());
+        TestMainWindow w;
+        QVERIFY2(!w.findChild<QThread*>(), "Network thread should not exist before first paint or send");
+        QVERIFY2(!w.createdWorker, "Network worker should not exist before first paint or send");
+
+        QVERIFY(QMetaObject::invokeMethod(&w, "onFirstFrame"));
+        QThread *thread = w.findChild<QThread*>();
+        QVERIFY2(thread, "Network thread not created after first frame");
+        QVERIFY2(w.createdWorker, "Network worker not created after first frame");
+        QCOMPARE(w.createdWorker->thread(), thread);
+        QTRY_VERIFY(thread->isRunning());
+    }
+
+    void testSchemaRestoreFromCache() {
+        TableSchema schema;
+        schema.tableName = "orders";
+        schema.rows = 250;
+        schema.outputFile = "orders.csv";
+        QJsonArray expectedFields;
+        for (int i = 0; i < 200; ++i) {
+            // Значения отличаются от умолчаний, чтобы пересборка виджета параметров была заметна
+            FieldSpec field;
+            field.name = QString("field_%1").arg(i);
+            field.type = QStringList{"int", "double", "string", "name"}.at(i % 4);
+            field.min = -i;
+            field.max = 1000 + i;
+            field.length = i % 50 + 20;
+            schema.fields.append(field);
+
+            QJsonObject expected;
+            expected["name"] = field.name;
+            expected["type"] = field.type;
+            if (field.type == "int" || field.type == "double") {
+                expected["params"] = QJsonObject{{"min", QString::number(field.min)}, {"max", QString::number(field.max)}};
+            } else if (field.type == "string") {
+                expected["params"] = QJsonObject{{"length", QString::number(field.length)}};
+            }
+            expectedFields.append(expected);
+        }
+        QVERIFY(SchemaCache::save(schema));
+
+        // Окно, закрытое до восстановления, не должно затирать кэш пустой формой
+        {
+            TestMainWindow unrestored;
+            unrestored.close();
+            TableSchema cached;
+            QVERIFY(SchemaCache::load(&cached));
+            QCOMPARE(cached.fields.size(), qsizetype(200));
+        }
+
+        TestMainWindow w;
+        QTableWidget *fieldsTable = w.findChild<QTableWidget*>("fieldsTable");
+        QPushButton *addFieldButton = w.findChild<QPushButton*>("addFieldButton");
+        QPushButton *removeFieldButton = w.findChild<QPushButton*>("removeFieldButton");
+        QPushButton *sendButton = w.findChild<QPushButton*>("sendButton");
+        QVERIFY(QMetaObject::invokeMethod(&w, "onFirstFrame"));
+
+        // Первая порция уже в таблице, остальные строки ещё ждут своей очереди
+        QCOMPARE(fieldsTable->rowCount(), 64);
+        QVERIFY(!addFieldButton->isEnabled());
+        QVERIFY(!removeFieldButton->isEnabled());
+        QTest::mouseClick(sendButton, Qt::LeftButton);
+        QCOMPARE(w.lastMessage.title, QString("Please Wait"));
+        QCOMPARE(w.lastMessage.text, QString("The last used schema is still being restored."));
+        QCOMPARE(w.lastMessage.type, QString("warning"));
+
+        QTRY_VERIFY(addFieldButton->isEnabled());
+        QVERIFY(removeFieldButton->isEnabled());
+        QCOMPARE(fieldsTable->rowCount(), 200);
+
+        QJsonObject expected;
+        expected["table_name"] = "orders";
+        expected["rows"] = 250;
+        expected["output_file"] = "orders.csv";
+        expected["fields"] = expectedFields;
+        QCOMPARE(w.createJsonBody(), expected);
+
+        QFile::remove(SchemaCache::defaultPath());
+    }
+
+    void testWorkerBatchSuccess() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        NetworkWorker worker;
+        QSignalSpy batchSpy(&worker, &NetworkWorker::batchFinished);
+        QSignalSpy errorSpy(&worker, &NetworkWorker::errorOccurred);
+        QSignalSpy finishedSpy(&worker, &NetworkWorker::finished);
+
+        MockNetworkReply *reply = startBatch(worker, dir.path());
+        reply->setHttpStatusCode(200);
+        reply->setContentType("multipart/mixed; boundary=b0undary");
+        reply->setRawData(batchBody());
+        reply->emitReadyRead();
+        reply->emitFinished();
+
+        QCOMPARE(errorSpy.count(), 0);
+        QCOMPARE(finishedSpy.count(), 1);
+        QCOMPARE(batchSpy.count(), 1);
+        QStringList files = batchSpy.first().first().toStringList();
+        QCOMPARE(files, QStringList({dir.filePath("users.csv"), dir.filePath("orders.csv")}));
+        QFile users(dir.filePath("users.csv"));
+        QVERIFY(users.open(QIODevice::ReadOnly));
+        QCOMPARE(users.readAll(), QByteArray("id,name\r\n1,Alice"));
+        QFile orders(dir.filePath("orders.csv"));
+        QVERIFY(orders.open(QIODevice::ReadOnly));
+        QCOMPARE(orders.readAll(), QByteArray("id\r\n7"));
+    }
+
+    void testWorkerBatchHttpError() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        NetworkWorker worker;
+        QSignalSpy batchSpy(&worker, &NetworkWorker::batchFinished);
+        QSignalSpy errorSpy(&worker, &NetworkWorker::errorOccurred);
+
+        // Тело ответа с ошибкой не разбирается и на диск не попадает
+        MockNetworkReply *reply = startBatch(worker, dir.path());
+        reply->setHttpStatusCode(500);
+        reply->setContentType("multipart/mixed; boundary=b0undary");
+        reply->setRawData(batchBody());
+        reply->setNetworkError(QNetworkReply::InternalServerError, "Internal Server Error");
+        reply->emitReadyRead();
+        reply->emitFinished();
+
+        QCOMPARE(batchSpy.count(), 0);
+        QCOMPARE(errorSpy.count(), 1);
+        QCOMPARE(errorSpy.first().first().toString(), QString("Internal Server Error"));
+        QVERIFY(QDir(dir.path()).isEmpty());
+    }
+
+    void testWorkerBatchNotMultipart() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        NetworkWorker worker;
+        QSignalSpy batchSpy(&worker, &NetworkWorker::batchFinished);
+        QSignalSpy errorSpy(&worker, &NetworkWorker::errorOccurred);
+        QSignalSpy finishedSpy(&worker, &NetworkWorker::finished);
+
+        MockNetworkReply *reply = startBatch(worker, dir.path());
+        reply->setHttpStatusCode(200);
+        reply->setContentType("text/csv");
+        reply->setRawData("id\r\n1\r\n");
+        reply->emitReadyRead();
+
+        // failBatch() прерывает ответ, и finished приходит из abort()
+        QCOMPARE(reply->error(), QNetworkReply::OperationCanceledError);
+        QCOMPARE(batchSpy.count(), 0);
+        QCOMPARE(finishedSpy.count(), 1);
+        QCOMPARE(errorSpy.count(), 1);
+        QCOMPARE(errorSpy.first().first().toString(), QString("Batch response is not a multipart body."));
+        QVERIFY(QDir(dir.path()).isEmpty());
+    }
+
+    void testWorkerBatchEmpty() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        NetworkWorker worker;
+        QSignalSpy errorSpy(&worker, &NetworkWorker::errorOccurred);
+
+        MockNetworkReply *reply = startBatch(worker, dir.path());
+        reply->setHttpStatusCode(200);
+        reply->setContentType("multipart/mixed; boundary=b0undary");
+        reply->emitFinished();
+
+        QCOMPARE(errorSpy.count(), 1);
+        QCOMPARE(errorSpy.first().first().toString(), QString("Batch response is empty."));
+    }
+
+    void testWorkerBatchCancelRemovesFiles() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        NetworkWorker worker;
+        QSignalSpy batchSpy(&worker, &NetworkWorker::batchFinished);
+        QSignalSpy errorSpy(&worker, &NetworkWorker::errorOccurred);
+        QSignalSpy finishedSpy(&worker, &NetworkWorker::finished);
+
+        // Первая часть уже сохранена, вторая пишется в момент отмены
+        QByteArray body = batchBody();
+        MockNetworkReply *reply = startBatch(worker, dir.path());
+        reply->setHttpStatusCode(200);
+        reply->setContentType("multipart/mixed; boundary=b0undary");
+        reply->setRawData(body.left(body.indexOf("id\r\n7") + 2));
+        reply->emitReadyRead();
+        QVERIFY(QFile::exists(dir.filePath("users.csv")));
+        QVERIFY(QFile::exists(dir.filePath("orders.csv")));
+
+        worker.cancelRequest();
+
+        QCOMPARE(finishedSpy.count(), 1);
+        QCOMPARE(errorSpy.count(), 0);
+        QCOMPARE(batchSpy.count(), 0);
+        QVERIFY(QDir(dir.path()).isEmpty());
+    }
+
+    void testWorkerBatchTruncatedRemovesFiles() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        NetworkWorker worker;
+        QSignalSpy batchSpy(&worker, &NetworkWorker::batchFinished);
+        QSignalSpy errorSpy(&worker, &NetworkWorker::errorOccurred);
+
+        QByteArray body = batchBody();
+        MockNetworkReply *reply = startBatch(worker, dir.path());
+        reply->setHttpStatusCode(200);
+        reply->setContentType("multipart/mixed; boundary=b0undary");
+        reply->setRawData(body.left(body.indexOf("id\r\n7")));
+        reply->emitReadyRead();
+        reply->emitFinished();
+
+        QCOMPARE(batchSpy.count(), 0);
+        QCOMPARE(errorSpy.count(), 1);
+        QCOMPARE(errorSpy.first().first().toString(), QString("Batch response ended unexpectedly."));
+        QVERIFY(QDir(dir.path()).isEmpty());
+    }
+
 private:
     QApplication *app = nullptr;
+
+    static QByteArray batchBody() {
+        return "--b0undary\r\n"
+               "Content-Disposition: attachment; filename=\"users.csv\"\r\n\r\n"
+               "id,name\r\n1,Alice"
+               "\r\n--b0undary\r\n"
+               "Content-Disposition: attachment; filename=\"orders.csv\"\r\n\r\n"
+               "id\r\n7"
+               "\r\n--b0undary--\r\n";
+    }
+
+    MockNetworkReply *startBatch(NetworkWorker &worker, const QString &outputDir) {
+        auto *manager = new MockNetworkAccessManager();
+        worker.setNetworkManager(manager);
+        worker.processBatchRequest(QNetworkRequest(QUrl("http://localhost:8080/generate/batch")), "{}", outputDir);
+        return manager->replies.last();
+    }
 };
 
 QTEST_MAIN(TestMainWindowTests)